@@ -0,0 +1,711 @@
+#include "GL/glew.h"
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "GLTrace.h"
+
+// replays a trace written by GLCapture as fast as the driver will take it
+// usage: GLReplay <trace> [iterations]
+
+typedef std::chrono::high_resolution_clock Clock;
+
+// one decoded record, we decode everything up front so parsing isn't in the timings
+struct Command
+{
+	GLTraceOp Op;
+	GLuint Args[6];
+	GLint Ints[4];
+	float Floats[16];
+	std::string Name;
+	const std::vector<unsigned char>* Blob;
+	const std::vector<unsigned char>* Blob2;
+};
+
+struct Trace
+{
+	std::unordered_map<uint64_t, std::vector<unsigned char>> Blobs;
+	// the snapshot of everything alive when the capture started
+	std::vector<Command> Prelude;
+	std::vector<std::vector<Command>> Frames;
+	// every uniform name the trace sets, per captured program id
+	std::unordered_map<GLuint, std::vector<std::string>> UniformNames;
+};
+
+struct CallStats
+{
+	uint64_t Count;
+	double Total;
+	double Max;
+};
+
+static const std::vector<unsigned char>* FindBlob(const Trace& trace, uint64_t hash)
+{
+	auto blob = trace.Blobs.find(hash);
+	return blob != trace.Blobs.end() ? &blob->second : nullptr;
+}
+
+static bool LoadTrace(const std::string& path, Trace& trace)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+	{
+		std::cout << "Error: couldn't open '" << path << "'" << std::endl;
+		return false;
+	}
+
+	std::vector<unsigned char> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+	GLTraceReader reader(data.data(), data.size());
+
+	if (reader.Read<uint32_t>() != GLTRACE_MAGIC || reader.Read<uint32_t>() != GLTRACE_VERSION)
+	{
+		std::cout << "Error: '" << path << "' isn't a version " << GLTRACE_VERSION << " trace" << std::endl;
+		return false;
+	}
+
+	std::vector<Command>* current = &trace.Prelude;
+	GLTraceOp lastOp = GLTraceOp::COUNT;
+
+	while (!reader.AtEnd())
+	{
+		Command command{};
+		command.Op = (GLTraceOp)reader.Read<uint8_t>();
+		lastOp = command.Op;
+
+		switch (command.Op)
+		{
+			case GLTraceOp::BLOB:
+			{
+				uint64_t hash = reader.Read<uint64_t>();
+				uint32_t size = reader.Read<uint32_t>();
+				const unsigned char* bytes = reader.Skip(size);
+				if (bytes)
+					trace.Blobs[hash].assign(bytes, bytes + size);
+				break;
+			}
+			case GLTraceOp::CREATE_BUFFER:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Args[1] = reader.Read<uint32_t>();
+				command.Args[2] = reader.Read<uint32_t>();
+				command.Blob = FindBlob(trace, reader.Read<uint64_t>());
+				break;
+			case GLTraceOp::CREATE_TEXTURE:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Ints[0] = reader.Read<int32_t>();
+				command.Ints[1] = reader.Read<int32_t>();
+				command.Blob = FindBlob(trace, reader.Read<uint64_t>());
+				break;
+			case GLTraceOp::CREATE_PROGRAM:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Blob = FindBlob(trace, reader.Read<uint64_t>());
+				command.Blob2 = FindBlob(trace, reader.Read<uint64_t>());
+				break;
+			case GLTraceOp::DELETE_BUFFER:
+			case GLTraceOp::DELETE_TEXTURE:
+			case GLTraceOp::DELETE_PROGRAM:
+			case GLTraceOp::CREATE_VERTEX_ARRAY:
+			case GLTraceOp::DELETE_VERTEX_ARRAY:
+			case GLTraceOp::BIND_VERTEX_ARRAY:
+			case GLTraceOp::ACTIVE_TEXTURE:
+			case GLTraceOp::BIND_TEXTURE:
+			case GLTraceOp::USE_PROGRAM:
+			case GLTraceOp::CLEAR:
+				command.Args[0] = reader.Read<uint32_t>();
+				break;
+			case GLTraceOp::VERTEX_ATTRIB:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Args[1] = reader.Read<uint32_t>();
+				command.Args[2] = reader.Read<uint32_t>();
+				command.Args[3] = reader.Read<uint8_t>();
+				command.Args[4] = reader.Read<uint32_t>();
+				command.Args[5] = reader.Read<uint32_t>();
+				break;
+			case GLTraceOp::BIND_BUFFER:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Args[1] = reader.Read<uint32_t>();
+				break;
+			case GLTraceOp::UNIFORM_1I:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Name = reader.ReadString();
+				command.Ints[0] = reader.Read<int32_t>();
+				break;
+			case GLTraceOp::UNIFORM_4F:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Name = reader.ReadString();
+				reader.ReadBytes(command.Floats, 4 * sizeof(float));
+				break;
+			case GLTraceOp::UNIFORM_MAT4F:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Name = reader.ReadString();
+				reader.ReadBytes(command.Floats, 16 * sizeof(float));
+				break;
+			case GLTraceOp::DRAW_ELEMENTS:
+				command.Args[0] = reader.Read<uint32_t>();
+				command.Args[1] = reader.Read<uint32_t>();
+				command.Args[2] = reader.Read<uint32_t>();
+				break;
+			case GLTraceOp::STATE:
+				command.Args[0] = reader.Read<uint8_t>();
+				command.Args[1] = reader.Read<uint32_t>();
+				command.Args[2] = reader.Read<uint32_t>();
+				reader.ReadBytes(command.Floats, 4 * sizeof(float));
+				reader.ReadBytes(command.Ints, 4 * sizeof(GLint));
+				break;
+			case GLTraceOp::BEGIN_FRAMES:
+			case GLTraceOp::END_FRAME:
+				trace.Frames.emplace_back();
+				current = &trace.Frames.back();
+				break;
+			default:
+				std::cout << "Error: unknown op " << (int)command.Op << " in trace" << std::endl;
+				return false;
+		}
+
+		if (reader.Failed())
+		{
+			break;
+		}
+
+		if (command.Op == GLTraceOp::UNIFORM_1I || command.Op == GLTraceOp::UNIFORM_4F || command.Op == GLTraceOp::UNIFORM_MAT4F)
+		{
+			std::vector<std::string>& names = trace.UniformNames[command.Args[0]];
+			if (std::find(names.begin(), names.end(), command.Name) == names.end())
+				names.push_back(command.Name);
+		}
+
+		if (command.Op != GLTraceOp::BLOB && command.Op != GLTraceOp::BEGIN_FRAMES && command.Op != GLTraceOp::END_FRAME)
+		{
+			current->push_back(std::move(command));
+		}
+	}
+
+	// BEGIN_FRAMES and END_FRAME open the next frame, so a whole trace ends on an empty one
+	// anything else means the capture got cut off, mid record or between two flushes,
+	// so drop the frame (or snapshot) in progress, half a frame would skew the timings
+	if (lastOp != GLTraceOp::BEGIN_FRAMES && lastOp != GLTraceOp::END_FRAME)
+	{
+		std::cout << "Warning: trace is truncated" << std::endl;
+		if (trace.Frames.empty())
+			trace.Prelude.clear();
+	}
+
+	if (!trace.Frames.empty())
+	{
+		trace.Frames.pop_back();
+	}
+
+	return true;
+}
+
+// re-issues commands, mapping the ids from the capture to the ones we get here
+class Replayer
+{
+private:
+	std::unordered_map<GLuint, GLuint> m_Buffers;
+	std::unordered_map<GLuint, GLuint> m_Textures;
+	std::unordered_map<GLuint, GLuint> m_Programs;
+	std::unordered_map<GLuint, GLuint> m_VertexArrays;
+	// keyed by the captured program id, but only valid for the program object we linked for it
+	std::unordered_map<GLuint, std::unordered_map<std::string, int>> m_UniformLocationCache;
+	const std::unordered_map<GLuint, std::vector<std::string>>& m_UniformNames;
+
+	// what we've bound on each texture unit, so a pass can start from a clean slate
+	std::vector<GLuint> m_BoundTextures;
+	GLuint m_ActiveSlot;
+
+public:
+	Replayer(const Trace& trace)
+		: m_UniformNames{ trace.UniformNames }, m_ActiveSlot{ 0 }
+	{
+		GLint textureUnits = 0;
+		glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &textureUnits);
+		m_BoundTextures.resize(textureUnits, 0);
+	}
+
+	~Replayer()
+	{
+		for (auto& buffer : m_Buffers)
+			glDeleteBuffers(1, &buffer.second);
+		for (auto& texture : m_Textures)
+			glDeleteTextures(1, &texture.second);
+		for (auto& program : m_Programs)
+			glDeleteProgram(program.second);
+		for (auto& vertexArray : m_VertexArrays)
+			glDeleteVertexArrays(1, &vertexArray.second);
+	}
+
+	// the snapshot only binds the units that were in use when we captured
+	// so clear the rest of what the last pass left behind before replaying it again
+	void ResetBindings()
+	{
+		for (GLuint slot = 0; slot < m_BoundTextures.size(); slot++)
+		{
+			if (m_BoundTextures[slot] == 0)
+				continue;
+
+			glActiveTexture(GL_TEXTURE0 + slot);
+			glBindTexture(GL_TEXTURE_2D, 0);
+			m_BoundTextures[slot] = 0;
+		}
+
+		glActiveTexture(GL_TEXTURE0);
+		m_ActiveSlot = 0;
+
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glUseProgram(0);
+	}
+
+	void Execute(const Command& command)
+	{
+		const GLuint* args = command.Args;
+
+		switch (command.Op)
+		{
+			case GLTraceOp::CREATE_BUFFER:
+			{
+				DeleteBuffer(args[0]);
+
+				GLuint id;
+				glGenBuffers(1, &id);
+				// the copy target leaves the vertex array alone, the trace has its own binds
+				glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+				glBufferData(GL_COPY_WRITE_BUFFER, args[2], command.Blob ? command.Blob->data() : nullptr, GL_STATIC_DRAW);
+				glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+				m_Buffers[args[0]] = id;
+				break;
+			}
+			case GLTraceOp::DELETE_BUFFER:
+				DeleteBuffer(args[0]);
+				break;
+			case GLTraceOp::CREATE_TEXTURE:
+			{
+				DeleteTexture(args[0]);
+
+				GLuint id;
+				glGenTextures(1, &id);
+				glBindTexture(GL_TEXTURE_2D, id);
+
+				// same params as Texture
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, command.Ints[0], command.Ints[1], 0, GL_RGBA, GL_UNSIGNED_BYTE,
+					command.Blob ? command.Blob->data() : nullptr);
+
+				// and unbind it again like Texture does, the trace binds it when it's needed
+				glBindTexture(GL_TEXTURE_2D, 0);
+				SetBoundTexture(0);
+
+				m_Textures[args[0]] = id;
+				break;
+			}
+			case GLTraceOp::DELETE_TEXTURE:
+				DeleteTexture(args[0]);
+				break;
+			case GLTraceOp::CREATE_PROGRAM:
+			{
+				DeleteProgram(args[0]);
+				m_Programs[args[0]] = CreateProgram(ToString(command.Blob), ToString(command.Blob2));
+
+				// look up every name the trace uses now, so frames don't pay for it,
+				// inactive uniforms included since the snapshot never sets those
+				auto names = m_UniformNames.find(args[0]);
+				if (names != m_UniformNames.end())
+				{
+					for (const std::string& name : names->second)
+						GetUniformLocation(args[0], name);
+				}
+				break;
+			}
+			case GLTraceOp::DELETE_PROGRAM:
+				DeleteProgram(args[0]);
+				break;
+			case GLTraceOp::CREATE_VERTEX_ARRAY:
+			{
+				DeleteVertexArray(args[0]);
+
+				GLuint id;
+				glGenVertexArrays(1, &id);
+				m_VertexArrays[args[0]] = id;
+				break;
+			}
+			case GLTraceOp::DELETE_VERTEX_ARRAY:
+				DeleteVertexArray(args[0]);
+				break;
+			case GLTraceOp::VERTEX_ATTRIB:
+				glEnableVertexAttribArray(args[0]);
+				glVertexAttribPointer(args[0], args[1], args[2], (GLboolean)args[3], args[4], (const void*)(uintptr_t)args[5]);
+				break;
+			case GLTraceOp::BIND_BUFFER:
+				glBindBuffer(args[0], Map(m_Buffers, args[1]));
+				break;
+			case GLTraceOp::BIND_VERTEX_ARRAY:
+				glBindVertexArray(Map(m_VertexArrays, args[0]));
+				break;
+			case GLTraceOp::ACTIVE_TEXTURE:
+				glActiveTexture(GL_TEXTURE0 + args[0]);
+				m_ActiveSlot = args[0];
+				break;
+			case GLTraceOp::BIND_TEXTURE:
+			{
+				GLuint id = Map(m_Textures, args[0]);
+				glBindTexture(GL_TEXTURE_2D, id);
+				SetBoundTexture(id);
+				break;
+			}
+			case GLTraceOp::USE_PROGRAM:
+				glUseProgram(Map(m_Programs, args[0]));
+				break;
+			case GLTraceOp::UNIFORM_1I:
+				glUniform1i(GetUniformLocation(args[0], command.Name), command.Ints[0]);
+				break;
+			case GLTraceOp::UNIFORM_4F:
+				glUniform4f(GetUniformLocation(args[0], command.Name), command.Floats[0], command.Floats[1], command.Floats[2], command.Floats[3]);
+				break;
+			case GLTraceOp::UNIFORM_MAT4F:
+				glUniformMatrix4fv(GetUniformLocation(args[0], command.Name), 1, GL_FALSE, command.Floats);
+				break;
+			case GLTraceOp::DRAW_ELEMENTS:
+				glDrawElements(args[0], args[1], args[2], nullptr);
+				break;
+			case GLTraceOp::CLEAR:
+				glClear(args[0]);
+				break;
+			case GLTraceOp::STATE:
+				if (args[0])
+					glEnable(GL_BLEND);
+				else
+					glDisable(GL_BLEND);
+				glBlendFunc(args[1], args[2]);
+				glClearColor(command.Floats[0], command.Floats[1], command.Floats[2], command.Floats[3]);
+				glViewport(command.Ints[0], command.Ints[1], command.Ints[2], command.Ints[3]);
+				break;
+			default:
+				break;
+		}
+	}
+
+private:
+	static GLuint Map(const std::unordered_map<GLuint, GLuint>& ids, GLuint id)
+	{
+		auto mapped = ids.find(id);
+		return mapped != ids.end() ? mapped->second : 0;
+	}
+
+	inline void SetBoundTexture(GLuint id)
+	{
+		if (m_ActiveSlot < m_BoundTextures.size())
+			m_BoundTextures[m_ActiveSlot] = id;
+	}
+
+	static std::string ToString(const std::vector<unsigned char>* blob)
+	{
+		return blob ? std::string(blob->begin(), blob->end()) : std::string();
+	}
+
+	// uniforms are looked up in the program they were captured against, same as Shader does
+	int GetUniformLocation(GLuint program, const std::string& name)
+	{
+		auto& cache = m_UniformLocationCache[program];
+		auto location = cache.find(name);
+		if (location != cache.end())
+			return location->second;
+
+		int result = glGetUniformLocation(Map(m_Programs, program), name.c_str());
+		cache[name] = result;
+		return result;
+	}
+
+	void DeleteBuffer(GLuint id)
+	{
+		auto buffer = m_Buffers.find(id);
+		if (buffer == m_Buffers.end())
+			return;
+
+		glDeleteBuffers(1, &buffer->second);
+		m_Buffers.erase(buffer);
+	}
+
+	void DeleteTexture(GLuint id)
+	{
+		auto texture = m_Textures.find(id);
+		if (texture == m_Textures.end())
+			return;
+
+		glDeleteTextures(1, &texture->second);
+		m_Textures.erase(texture);
+	}
+
+	void DeleteProgram(GLuint id)
+	{
+		auto program = m_Programs.find(id);
+		if (program == m_Programs.end())
+			return;
+
+		glDeleteProgram(program->second);
+		m_Programs.erase(program);
+		m_UniformLocationCache.erase(id);
+	}
+
+	void DeleteVertexArray(GLuint id)
+	{
+		auto vertexArray = m_VertexArrays.find(id);
+		if (vertexArray == m_VertexArrays.end())
+			return;
+
+		glDeleteVertexArrays(1, &vertexArray->second);
+		m_VertexArrays.erase(vertexArray);
+	}
+
+	static GLuint CompileShader(const std::string& source, GLuint type)
+	{
+		GLuint id = glCreateShader(type);
+		const char* src = source.c_str();
+		glShaderSource(id, 1, &src, nullptr);
+		glCompileShader(id);
+
+		int result;
+		glGetShaderiv(id, GL_COMPILE_STATUS, &result);
+
+		if (result == GL_FALSE)
+		{
+			int length;
+			glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length);
+			std::string message(length, '\0');
+			glGetShaderInfoLog(id, length, &length, &message[0]);
+
+			std::cout << message << std::endl;
+
+			glDeleteShader(id);
+
+			return 0;
+		}
+
+		return id;
+	}
+
+	static GLuint CreateProgram(const std::string& vertexShader, const std::string& fragmentShader)
+	{
+		GLuint program = glCreateProgram();
+		GLuint vs = CompileShader(vertexShader, GL_VERTEX_SHADER);
+		GLuint fs = CompileShader(fragmentShader, GL_FRAGMENT_SHADER);
+
+		glAttachShader(program, vs);
+		glAttachShader(program, fs);
+		glLinkProgram(program);
+
+		glDeleteShader(vs);
+		glDeleteShader(fs);
+
+		return program;
+	}
+};
+
+static double Milliseconds(Clock::duration duration)
+{
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: GLReplay <trace> [iterations]" << std::endl;
+		return -1;
+	}
+
+	int iterations = argc > 2 ? std::max(1, atoi(argv[2])) : 10;
+
+	Trace trace;
+	if (!LoadTrace(argv[1], trace))
+		return -1;
+
+	if (trace.Frames.empty())
+	{
+		std::cout << "Error: trace has no frames" << std::endl;
+		return -1;
+	}
+
+	// the viewport from the snapshot sizes our offscreen target
+	GLint width = 640, height = 480;
+	for (const Command& command : trace.Prelude)
+	{
+		if (command.Op == GLTraceOp::STATE && command.Ints[2] > 0 && command.Ints[3] > 0)
+		{
+			width = command.Ints[2];
+			height = command.Ints[3];
+		}
+	}
+
+	if (!glfwInit())
+		return -1;
+
+	// headless, a hidden window just to get us a context
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	GLFWwindow* window = glfwCreateWindow(width, height, "GLReplay", NULL, NULL);
+	if (!window)
+	{
+		glfwTerminate();
+		return -1;
+	}
+
+	glfwMakeContextCurrent(window);
+
+	if (glewInit() != GLEW_OK)
+	{
+		std::cout << "Error!" << std::endl;
+	}
+
+	std::cout << glGetString(GL_VERSION) << std::endl;
+
+	{
+		// render into our own framebuffer, a hidden window's pixels can be thrown away
+		GLuint framebuffer, colorBuffer;
+		glGenFramebuffers(1, &framebuffer);
+		glGenRenderbuffers(1, &colorBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+
+		std::vector<GLuint> queries(trace.Frames.size());
+		glGenQueries((GLsizei)queries.size(), queries.data());
+
+		CallStats calls[(size_t)GLTraceOp::COUNT] = {};
+		std::vector<double> frameCPU(trace.Frames.size(), 0.0);
+		std::vector<double> frameGPU(trace.Frames.size(), 0.0);
+		std::vector<double> allCPU, allGPU;
+		double preludeTime = 0.0;
+
+		Replayer replayer(trace);
+
+		// rebuild the snapshot before each pass, so every pass starts from the captured state
+		auto runPrelude = [&]()
+		{
+			Clock::time_point preludeStart = Clock::now();
+			replayer.ResetBindings();
+			for (const Command& command : trace.Prelude)
+			{
+				replayer.Execute(command);
+			}
+			glFinish();
+			preludeTime += Milliseconds(Clock::now() - preludeStart);
+		};
+
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			// the frame timings come from a clean pass, timing every call costs more than the calls in a small frame
+			runPrelude();
+
+			for (size_t frame = 0; frame < trace.Frames.size(); frame++)
+			{
+				glBeginQuery(GL_TIME_ELAPSED, queries[frame]);
+				Clock::time_point frameStart = Clock::now();
+
+				for (const Command& command : trace.Frames[frame])
+				{
+					replayer.Execute(command);
+				}
+
+				double cpu = Milliseconds(Clock::now() - frameStart);
+				glEndQuery(GL_TIME_ELAPSED);
+
+				frameCPU[frame] += cpu;
+				allCPU.push_back(cpu);
+			}
+
+			// only read the queries back once the whole pass is queued, so we never stall mid pass
+			glFinish();
+			for (size_t frame = 0; frame < trace.Frames.size(); frame++)
+			{
+				GLuint64 nanoseconds = 0;
+				glGetQueryObjectui64v(queries[frame], GL_QUERY_RESULT, &nanoseconds);
+
+				double gpu = nanoseconds / 1000000.0;
+				frameGPU[frame] += gpu;
+				allGPU.push_back(gpu);
+			}
+
+			// then a second pass just for the per call table
+			runPrelude();
+
+			for (size_t frame = 0; frame < trace.Frames.size(); frame++)
+			{
+				for (const Command& command : trace.Frames[frame])
+				{
+					Clock::time_point callStart = Clock::now();
+					replayer.Execute(command);
+					double elapsed = Milliseconds(Clock::now() - callStart);
+
+					CallStats& stats = calls[(size_t)command.Op];
+					stats.Count++;
+					stats.Total += elapsed;
+					stats.Max = std::max(stats.Max, elapsed);
+				}
+			}
+			glFinish();
+		}
+
+		std::cout << std::fixed << std::setprecision(3);
+		std::cout << trace.Frames.size() << " frames x " << iterations << " iterations, "
+			<< width << "x" << height << ", snapshot rebuild avg " << preludeTime / (iterations * 2) << " ms" << std::endl;
+
+		std::cout << std::endl << std::left << std::setw(20) << "call"
+			<< std::right << std::setw(10) << "count" << std::setw(14) << "total ms"
+			<< std::setw(12) << "avg us" << std::setw(12) << "max us" << std::endl;
+		for (size_t op = 0; op < (size_t)GLTraceOp::COUNT; op++)
+		{
+			const CallStats& stats = calls[op];
+			if (stats.Count == 0)
+				continue;
+
+			std::cout << std::left << std::setw(20) << GLTraceOpName((GLTraceOp)op)
+				<< std::right << std::setw(10) << stats.Count << std::setw(14) << stats.Total
+				<< std::setw(12) << stats.Total / stats.Count * 1000.0 << std::setw(12) << stats.Max * 1000.0 << std::endl;
+		}
+
+		std::cout << std::endl << std::setw(8) << "frame" << std::setw(10) << "calls"
+			<< std::setw(12) << "cpu ms" << std::setw(12) << "gpu ms" << std::endl;
+		for (size_t frame = 0; frame < trace.Frames.size(); frame++)
+		{
+			std::cout << std::setw(8) << frame << std::setw(10) << trace.Frames[frame].size()
+				<< std::setw(12) << frameCPU[frame] / iterations << std::setw(12) << frameGPU[frame] / iterations << std::endl;
+		}
+
+		std::sort(allCPU.begin(), allCPU.end());
+		std::sort(allGPU.begin(), allGPU.end());
+
+		double cpuSum = 0.0, gpuSum = 0.0;
+		for (double cpu : allCPU)
+			cpuSum += cpu;
+		for (double gpu : allGPU)
+			gpuSum += gpu;
+
+		size_t p95 = allCPU.size() * 95 / 100;
+		std::cout << std::endl
+			<< "cpu ms: min " << allCPU.front() << ", avg " << cpuSum / allCPU.size() << ", p95 " << allCPU[p95] << ", max " << allCPU.back() << std::endl
+			<< "gpu ms: min " << allGPU.front() << ", avg " << gpuSum / allGPU.size() << ", p95 " << allGPU[p95] << ", max " << allGPU.back() << std::endl;
+
+		glDeleteQueries((GLsizei)queries.size(), queries.data());
+		glDeleteRenderbuffers(1, &colorBuffer);
+		glDeleteFramebuffers(1, &framebuffer);
+	}
+
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,284 @@
+#include "FramePacer.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <timeapi.h>
+#endif
+
+// the os can oversleep by a ms or two, so we stop sleeping this far out and spin the rest
+static const double SPIN_THRESHOLD = 0.002;
+// don't let a long stall (dragging the window, a breakpoint) queue up seconds of simulation
+static const double MAX_FRAME_TIME = 0.25;
+// 1 second in nanoseconds, how long we'll block on a fence before checking again
+static const GLuint64 FENCE_TIMEOUT = 1000000000;
+
+FramePacer::FramePacer(Mode mode, double targetFPS, double simulationHz, GLuint maxFramesInFlight)
+	: m_Mode{ mode }, m_TargetFrameTime{ 1.0 / targetFPS }, m_SimulationStep{ 1.0 / simulationHz },
+	m_MaxFramesInFlight{ maxFramesInFlight > 0 ? maxFramesInFlight : 1 },
+	m_InFlightHead{ 0 }, m_InFlightCount{ 0 },
+	m_NextFrameDeadline{ 0.0 }, m_Accumulator{ 0.0 }, m_ClockOffset{ 0.0 },
+	m_LastTiming{ 0.0, 0.0, -1.0 },
+	m_StatsFrames{ 0 }, m_StatsPresentSum{ 0.0 }, m_StatsPresentMax{ 0.0 },
+	m_StatsCompleteSum{ 0.0 }, m_StatsCompleteMax{ 0.0 }, m_StatsCompleteCount{ 0 }
+{
+	m_InFlight.resize(m_MaxFramesInFlight, { nullptr, 0, 0.0, 0.0 });
+	for (InFlightFrame& frame : m_InFlight)
+	{
+		glGenQueries(1, &frame.Query);
+	}
+
+	m_FrameStart = glfwGetTime();
+	m_InputTime = m_FrameStart;
+	m_StatsStart = m_FrameStart;
+
+#ifdef _WIN32
+	// the default windows timer ticks every ~15.6ms, way too coarse for the limiter
+	timeBeginPeriod(1);
+#endif
+
+	SetMode(mode);
+}
+
+FramePacer::~FramePacer()
+{
+	for (GLuint i = 0; i < m_InFlightCount; i++)
+	{
+		glDeleteSync(m_InFlight[(m_InFlightHead + i) % m_MaxFramesInFlight].Fence);
+	}
+
+	for (InFlightFrame& frame : m_InFlight)
+	{
+		glDeleteQueries(1, &frame.Query);
+	}
+
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::SetMode(Mode mode)
+{
+	m_Mode = mode;
+
+	switch (mode)
+	{
+		case Mode::VSYNC:
+			glfwSwapInterval(1);
+			break;
+		case Mode::ADAPTIVE_VSYNC:
+			// -1 syncs like normal, but a late frame tears instead of waiting a whole extra refresh
+			if (glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+			{
+				glfwSwapInterval(-1);
+			}
+			else
+			{
+				std::cout << "Warning: adaptive vsync isn't supported, using vsync" << std::endl;
+				glfwSwapInterval(1);
+			}
+			break;
+		case Mode::UNCAPPED:
+		case Mode::LIMITED:
+			// the limiter does the waiting, not the swap
+			glfwSwapInterval(0);
+			break;
+	}
+
+	m_NextFrameDeadline = 0.0;
+
+	std::cout << "[FramePacer] mode: " << GetModeName(mode) << std::endl;
+}
+
+void FramePacer::SetTargetFPS(double fps)
+{
+	m_TargetFrameTime = 1.0 / fps;
+	m_NextFrameDeadline = 0.0;
+}
+
+void FramePacer::BeginFrame()
+{
+	// the driver will happily queue up frames, each one adding a frame of latency
+	// so we block here until the gpu is under our cap
+	RetireFrames(true);
+
+	if (m_Mode == Mode::LIMITED)
+	{
+		WaitForLimiter();
+	}
+
+	double now = glfwGetTime();
+	double frameTime = now - m_FrameStart;
+	m_FrameStart = now;
+	m_InputTime = now;
+
+	// line the gpu clock up with ours, so a gpu timestamp can be compared to the input time
+	GLint64 gpuNow;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	m_ClockOffset = glfwGetTime() - gpuNow / 1000000000.0;
+
+	m_LastTiming.FrameTime = frameTime;
+	m_Accumulator += frameTime < MAX_FRAME_TIME ? frameTime : MAX_FRAME_TIME;
+}
+
+void FramePacer::MarkInputSampled()
+{
+	m_InputTime = glfwGetTime();
+}
+
+bool FramePacer::StepSimulation()
+{
+	if (m_Accumulator < m_SimulationStep)
+	{
+		return false;
+	}
+
+	m_Accumulator -= m_SimulationStep;
+	return true;
+}
+
+void FramePacer::Present(GLFWwindow* window)
+{
+	glfwSwapBuffers(window);
+
+	double now = glfwGetTime();
+	m_LastTiming.InputToPresent = now - m_InputTime;
+
+	// the timestamp and fence land after everything we issued for the frame
+	// the fence tells us when we can read the timestamp, the timestamp says when the gpu got there
+	GLuint tail = (m_InFlightHead + m_InFlightCount) % m_MaxFramesInFlight;
+	InFlightFrame& frame = m_InFlight[tail];
+	glQueryCounter(frame.Query, GL_TIMESTAMP);
+	frame.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	frame.InputTime = m_InputTime;
+	frame.ClockOffset = m_ClockOffset;
+	m_InFlightCount++;
+
+	m_StatsFrames++;
+	m_StatsPresentSum += m_LastTiming.InputToPresent;
+	if (m_LastTiming.InputToPresent > m_StatsPresentMax)
+		m_StatsPresentMax = m_LastTiming.InputToPresent;
+
+	ReportStats(now);
+}
+
+const char* FramePacer::GetModeName(Mode mode)
+{
+	switch (mode)
+	{
+		case Mode::VSYNC:
+			return "vsync";
+		case Mode::ADAPTIVE_VSYNC:
+			return "adaptive vsync";
+		case Mode::UNCAPPED:
+			return "uncapped";
+		case Mode::LIMITED:
+			return "limited";
+	}
+	return "unknown";
+}
+
+void FramePacer::WaitForLimiter()
+{
+	double remaining = m_NextFrameDeadline - glfwGetTime();
+
+	if (remaining > SPIN_THRESHOLD)
+	{
+		std::this_thread::sleep_for(std::chrono::duration<double>(remaining - SPIN_THRESHOLD));
+	}
+
+	while (glfwGetTime() < m_NextFrameDeadline)
+	{
+		std::this_thread::yield();
+	}
+
+	// schedule off the deadline, not off now, so we don't drift
+	// but if we fell behind, don't rush frames out trying to catch up
+	double now = glfwGetTime();
+	m_NextFrameDeadline += m_TargetFrameTime;
+	if (m_NextFrameDeadline < now)
+	{
+		m_NextFrameDeadline = now + m_TargetFrameTime;
+	}
+}
+
+void FramePacer::RetireFrames(bool block)
+{
+	while (m_InFlightCount > 0)
+	{
+		InFlightFrame& frame = m_InFlight[m_InFlightHead];
+
+		// we only wait on the oldest frame, and only if we're at the cap
+		// otherwise just pick up whatever has already finished
+		bool mustWait = block && m_InFlightCount >= m_MaxFramesInFlight;
+
+		GLenum result = glClientWaitSync(frame.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, mustWait ? FENCE_TIMEOUT : 0);
+
+		if (result == GL_TIMEOUT_EXPIRED)
+		{
+			if (!mustWait)
+				break;
+
+			continue;
+		}
+
+		if (result != GL_WAIT_FAILED)
+		{
+			RecordCompletion(frame);
+		}
+
+		glDeleteSync(frame.Fence);
+		frame.Fence = nullptr;
+
+		m_InFlightHead = (m_InFlightHead + 1) % m_MaxFramesInFlight;
+		m_InFlightCount--;
+	}
+}
+
+void FramePacer::RecordCompletion(const InFlightFrame& frame)
+{
+	// the fence has signalled so this won't stall
+	GLuint64 gpuTime = 0;
+	glGetQueryObjectui64v(frame.Query, GL_QUERY_RESULT, &gpuTime);
+
+	m_LastTiming.InputToComplete = gpuTime / 1000000000.0 + frame.ClockOffset - frame.InputTime;
+
+	m_StatsCompleteCount++;
+	m_StatsCompleteSum += m_LastTiming.InputToComplete;
+	if (m_LastTiming.InputToComplete > m_StatsCompleteMax)
+		m_StatsCompleteMax = m_LastTiming.InputToComplete;
+}
+
+void FramePacer::ReportStats(double now)
+{
+	double elapsed = now - m_StatsStart;
+
+	if (elapsed < 1.0)
+	{
+		return;
+	}
+
+	std::cout << std::fixed << std::setprecision(2)
+		<< "[FramePacer] " << GetModeName(m_Mode)
+		<< " | " << m_StatsFrames / elapsed << " fps"
+		<< " | input->present avg " << m_StatsPresentSum / m_StatsFrames * 1000.0
+		<< " ms, max " << m_StatsPresentMax * 1000.0 << " ms";
+
+	if (m_StatsCompleteCount > 0)
+	{
+		std::cout << " | input->gpu done avg " << m_StatsCompleteSum / m_StatsCompleteCount * 1000.0
+			<< " ms, max " << m_StatsCompleteMax * 1000.0 << " ms";
+	}
+
+	std::cout << std::defaultfloat << std::endl;
+
+	m_StatsStart = now;
+	m_StatsFrames = 0;
+	m_StatsPresentSum = m_StatsPresentMax = 0.0;
+	m_StatsCompleteSum = m_StatsCompleteMax = 0.0;
+	m_StatsCompleteCount = 0;
+}
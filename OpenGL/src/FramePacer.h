@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vector>
+#include "GL/glew.h"
+#include <GLFW/glfw3.h>
+
+// per frame timings, all in seconds
+struct FrameTiming
+{
+	// time between the start of this frame and the last one
+	double FrameTime;
+	// input sampled -> glfwSwapBuffers returned
+	double InputToPresent;
+	// input sampled -> gpu finished the frame (from a timestamp query, not when we noticed)
+	// this is for the most recently retired frame, -1 until one retires
+	double InputToComplete;
+};
+
+class FramePacer
+{
+public:
+	enum class Mode
+	{
+		VSYNC = 0, ADAPTIVE_VSYNC, UNCAPPED, LIMITED
+	};
+
+private:
+	struct InFlightFrame
+	{
+		GLsync Fence;
+		// GL_TIMESTAMP written right next to the fence
+		GLuint Query;
+		double InputTime;
+		// gpu clock -> glfwGetTime, measured when this frame started
+		double ClockOffset;
+	};
+
+	Mode m_Mode;
+	double m_TargetFrameTime;
+	double m_SimulationStep;
+	GLuint m_MaxFramesInFlight;
+
+	// ring of fences, one per frame the gpu hasn't finished yet
+	std::vector<InFlightFrame> m_InFlight;
+	GLuint m_InFlightHead;
+	GLuint m_InFlightCount;
+
+	double m_FrameStart;
+	double m_NextFrameDeadline;
+	double m_InputTime;
+	double m_Accumulator;
+	double m_ClockOffset;
+
+	FrameTiming m_LastTiming;
+
+	// rolling stats, printed about once a second
+	double m_StatsStart;
+	GLuint m_StatsFrames;
+	double m_StatsPresentSum, m_StatsPresentMax;
+	double m_StatsCompleteSum, m_StatsCompleteMax;
+	GLuint m_StatsCompleteCount;
+
+public:
+	FramePacer(Mode mode = Mode::VSYNC, double targetFPS = 60.0, double simulationHz = 60.0, GLuint maxFramesInFlight = 2);
+	~FramePacer();
+
+	// needs a current context, sets the swap interval for the mode
+	void SetMode(Mode mode);
+	void SetTargetFPS(double fps);
+
+	// throttle (frames in flight, then the limiter) and start the frame clock
+	void BeginFrame();
+	// call right after glfwPollEvents so latency is measured from the freshest input
+	void MarkInputSampled();
+	// true while there's a fixed simulation step left to run this frame
+	bool StepSimulation();
+	// swap, fence the frame and record its timing
+	void Present(GLFWwindow* window);
+
+	inline Mode GetMode() const { return m_Mode; }
+	inline float GetSimulationStep() const { return (float)m_SimulationStep; }
+	// how far we are between the last two simulation states, for interpolating
+	inline float GetInterpolationAlpha() const { return (float)(m_Accumulator / m_SimulationStep); }
+	inline const FrameTiming& GetLastTiming() const { return m_LastTiming; }
+
+	static const char* GetModeName(Mode mode);
+
+private:
+	void WaitForLimiter();
+	void RetireFrames(bool block);
+	void RecordCompletion(const InFlightFrame& frame);
+	void ReportStats(double now);
+};
@@ -0,0 +1,563 @@
+#include "GLCapture.h"
+#include <iostream>
+
+// hand the packet to the writer once it gets this big, even mid frame
+static const size_t FLUSH_SIZE = 4 * 1024 * 1024;
+
+GLCapture& GLCapture::Get()
+{
+	static GLCapture instance;
+	return instance;
+}
+
+GLCapture::GLCapture()
+	: m_Capturing{ false }, m_FramesLeft{ 0 }, m_FramesCaptured{ 0 }, m_StopWriter{ false }, m_WriteFailed{ false }
+{
+}
+
+GLCapture::~GLCapture()
+{
+	End();
+}
+
+bool GLCapture::Begin(const std::string& path, GLuint frames/*=0*/)
+{
+	if (m_Capturing)
+	{
+		End();
+	}
+
+	m_File.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_File)
+	{
+		std::cout << "Warning: couldn't open capture file '" << path << "'" << std::endl;
+		return false;
+	}
+
+	m_WrittenBlobs.clear();
+	m_Packet.clear();
+	m_StopWriter = false;
+	m_WriteFailed = false;
+	m_FramesLeft = frames;
+	m_FramesCaptured = 0;
+
+	GLTraceWrite(m_Packet, GLTRACE_MAGIC);
+	GLTraceWrite(m_Packet, GLTRACE_VERSION);
+
+	m_Writer = std::thread(&GLCapture::WriterLoop, this);
+	m_Capturing = true;
+
+	Snapshot();
+	Flush();
+
+	std::cout << "[GLCapture] capturing to " << path << std::endl;
+	return true;
+}
+
+void GLCapture::End()
+{
+	if (!m_Capturing)
+	{
+		return;
+	}
+
+	m_Capturing = false;
+	Flush();
+
+	{
+		std::lock_guard<std::mutex> lock(m_QueueMutex);
+		m_StopWriter = true;
+	}
+	m_QueueSignal.notify_one();
+	m_Writer.join();
+
+	m_File.close();
+	if (m_WriteFailed || !m_File)
+	{
+		std::cout << "Warning: couldn't write the whole capture file, the trace is incomplete" << std::endl;
+		return;
+	}
+
+	std::cout << "[GLCapture] captured " << m_FramesCaptured << " frames" << std::endl;
+}
+
+void GLCapture::OnCreateBuffer(GLuint id, GLenum target, const void* data, GLuint size)
+{
+	m_Buffers[id] = { target, size };
+
+	if (!m_Capturing)
+		return;
+
+	// the blob has to land before the record that refers to it
+	uint64_t blob = WriteBlob(data, size);
+
+	WriteOp(GLTraceOp::CREATE_BUFFER);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+	GLTraceWrite(m_Packet, (uint32_t)target);
+	GLTraceWrite(m_Packet, (uint32_t)size);
+	GLTraceWrite(m_Packet, blob);
+}
+
+void GLCapture::OnDeleteBuffer(GLuint id)
+{
+	m_Buffers.erase(id);
+
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::DELETE_BUFFER);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnCreateTexture(GLuint id, int width, int height, const void* pixels)
+{
+	m_Textures[id] = { width, height };
+
+	if (!m_Capturing)
+		return;
+
+	uint64_t blob = WriteBlob(pixels, (size_t)width * height * 4);
+
+	WriteOp(GLTraceOp::CREATE_TEXTURE);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+	GLTraceWrite(m_Packet, (int32_t)width);
+	GLTraceWrite(m_Packet, (int32_t)height);
+	GLTraceWrite(m_Packet, blob);
+}
+
+void GLCapture::OnDeleteTexture(GLuint id)
+{
+	m_Textures.erase(id);
+
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::DELETE_TEXTURE);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnCreateProgram(GLuint id, const std::string& vertexSource, const std::string& fragmentSource)
+{
+	m_Programs[id] = { vertexSource, fragmentSource };
+
+	if (!m_Capturing)
+		return;
+
+	uint64_t vertexBlob = WriteBlob(vertexSource.data(), vertexSource.size());
+	uint64_t fragmentBlob = WriteBlob(fragmentSource.data(), fragmentSource.size());
+
+	WriteOp(GLTraceOp::CREATE_PROGRAM);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+	GLTraceWrite(m_Packet, vertexBlob);
+	GLTraceWrite(m_Packet, fragmentBlob);
+}
+
+void GLCapture::OnDeleteProgram(GLuint id)
+{
+	m_Programs.erase(id);
+
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::DELETE_PROGRAM);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnCreateVertexArray(GLuint id)
+{
+	m_VertexArrays.insert(id);
+
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::CREATE_VERTEX_ARRAY);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnDeleteVertexArray(GLuint id)
+{
+	m_VertexArrays.erase(id);
+
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::DELETE_VERTEX_ARRAY);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnVertexAttrib(GLuint index, GLuint count, GLenum type, unsigned char normalized, GLuint stride, GLuint offset)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::VERTEX_ATTRIB);
+	GLTraceWrite(m_Packet, (uint32_t)index);
+	GLTraceWrite(m_Packet, (uint32_t)count);
+	GLTraceWrite(m_Packet, (uint32_t)type);
+	GLTraceWrite(m_Packet, (uint8_t)normalized);
+	GLTraceWrite(m_Packet, (uint32_t)stride);
+	GLTraceWrite(m_Packet, (uint32_t)offset);
+}
+
+void GLCapture::OnBindBuffer(GLenum target, GLuint id)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::BIND_BUFFER);
+	GLTraceWrite(m_Packet, (uint32_t)target);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnBindVertexArray(GLuint id)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::BIND_VERTEX_ARRAY);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnActiveTexture(GLuint slot)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::ACTIVE_TEXTURE);
+	GLTraceWrite(m_Packet, (uint32_t)slot);
+}
+
+void GLCapture::OnBindTexture(GLuint id)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::BIND_TEXTURE);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnUseProgram(GLuint id)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::USE_PROGRAM);
+	GLTraceWrite(m_Packet, (uint32_t)id);
+}
+
+void GLCapture::OnUniform1i(GLuint program, const std::string& name, int v0)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::UNIFORM_1I);
+	GLTraceWrite(m_Packet, (uint32_t)program);
+	GLTraceWriteString(m_Packet, name);
+	GLTraceWrite(m_Packet, (int32_t)v0);
+}
+
+void GLCapture::OnUniform4f(GLuint program, const std::string& name, float v0, float v1, float v2, float v3)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::UNIFORM_4F);
+	GLTraceWrite(m_Packet, (uint32_t)program);
+	GLTraceWriteString(m_Packet, name);
+	GLTraceWrite(m_Packet, v0);
+	GLTraceWrite(m_Packet, v1);
+	GLTraceWrite(m_Packet, v2);
+	GLTraceWrite(m_Packet, v3);
+}
+
+void GLCapture::OnUniformMat4f(GLuint program, const std::string& name, const float* matrix)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::UNIFORM_MAT4F);
+	GLTraceWrite(m_Packet, (uint32_t)program);
+	GLTraceWriteString(m_Packet, name);
+	GLTraceWriteBytes(m_Packet, matrix, 16 * sizeof(float));
+}
+
+void GLCapture::OnDrawElements(GLenum mode, GLuint count, GLenum type)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::DRAW_ELEMENTS);
+	GLTraceWrite(m_Packet, (uint32_t)mode);
+	GLTraceWrite(m_Packet, (uint32_t)count);
+	GLTraceWrite(m_Packet, (uint32_t)type);
+}
+
+void GLCapture::OnClear(GLbitfield mask)
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::CLEAR);
+	GLTraceWrite(m_Packet, (uint32_t)mask);
+}
+
+void GLCapture::OnEndFrame()
+{
+	if (!m_Capturing)
+		return;
+
+	WriteOp(GLTraceOp::END_FRAME);
+	m_FramesCaptured++;
+	Flush();
+
+	if (m_FramesLeft > 0 && --m_FramesLeft == 0)
+	{
+		End();
+	}
+}
+
+uint64_t GLCapture::WriteBlob(const void* data, size_t size)
+{
+	// 0 means "no data", e.g. a buffer created without an upload
+	if (!data || size == 0)
+		return 0;
+
+	uint64_t hash = GLTraceHash(data, size);
+
+	if (m_WrittenBlobs.insert(hash).second)
+	{
+		WriteOp(GLTraceOp::BLOB);
+		GLTraceWrite(m_Packet, hash);
+		GLTraceWrite(m_Packet, (uint32_t)size);
+		GLTraceWriteBytes(m_Packet, data, size);
+
+		if (m_Packet.size() > FLUSH_SIZE)
+			Flush();
+	}
+
+	return hash;
+}
+
+void GLCapture::Snapshot()
+{
+	// remember what's bound, reading objects back means binding them
+	GLint program = 0, vertexArray = 0, arrayBuffer = 0, activeTexture = GL_TEXTURE0, copyReadBuffer = 0, texture2D = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertexArray);
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+	glGetIntegerv(GL_COPY_READ_BUFFER_BINDING, &copyReadBuffer);
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture2D);
+
+	std::vector<unsigned char> data;
+
+	// buffers go through the copy target so no vertex array sees them bound
+	for (const auto& buffer : m_Buffers)
+	{
+		data.resize(buffer.second.Size);
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer.first);
+		glGetBufferSubData(GL_COPY_READ_BUFFER, 0, buffer.second.Size, data.data());
+
+		uint64_t blob = WriteBlob(data.data(), data.size());
+
+		WriteOp(GLTraceOp::CREATE_BUFFER);
+		GLTraceWrite(m_Packet, (uint32_t)buffer.first);
+		GLTraceWrite(m_Packet, (uint32_t)buffer.second.Target);
+		GLTraceWrite(m_Packet, (uint32_t)buffer.second.Size);
+		GLTraceWrite(m_Packet, blob);
+	}
+	glBindBuffer(GL_COPY_READ_BUFFER, copyReadBuffer);
+
+	for (const auto& texture : m_Textures)
+	{
+		data.resize((size_t)texture.second.Width * texture.second.Height * 4);
+		glBindTexture(GL_TEXTURE_2D, texture.first);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+
+		uint64_t blob = WriteBlob(data.data(), data.size());
+
+		WriteOp(GLTraceOp::CREATE_TEXTURE);
+		GLTraceWrite(m_Packet, (uint32_t)texture.first);
+		GLTraceWrite(m_Packet, (int32_t)texture.second.Width);
+		GLTraceWrite(m_Packet, (int32_t)texture.second.Height);
+		GLTraceWrite(m_Packet, blob);
+	}
+	glBindTexture(GL_TEXTURE_2D, texture2D);
+
+	for (const auto& shader : m_Programs)
+	{
+		uint64_t vertexBlob = WriteBlob(shader.second.VertexSource.data(), shader.second.VertexSource.size());
+		uint64_t fragmentBlob = WriteBlob(shader.second.FragmentSource.data(), shader.second.FragmentSource.size());
+
+		WriteOp(GLTraceOp::CREATE_PROGRAM);
+		GLTraceWrite(m_Packet, (uint32_t)shader.first);
+		GLTraceWrite(m_Packet, vertexBlob);
+		GLTraceWrite(m_Packet, fragmentBlob);
+	}
+
+	// a vertex array's layout lives in GL, so walk its attributes to rebuild it
+	GLint maxAttribs = 0;
+	glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttribs);
+
+	for (GLuint id : m_VertexArrays)
+	{
+		glBindVertexArray(id);
+
+		WriteOp(GLTraceOp::CREATE_VERTEX_ARRAY);
+		GLTraceWrite(m_Packet, (uint32_t)id);
+		OnBindVertexArray(id);
+
+		for (GLint i = 0; i < maxAttribs; i++)
+		{
+			GLint enabled = 0;
+			glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &enabled);
+			if (!enabled)
+				continue;
+
+			GLint buffer, count, type, normalized, stride;
+			void* pointer;
+			glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &buffer);
+			glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_SIZE, &count);
+			glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_TYPE, &type);
+			glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_NORMALIZED, &normalized);
+			glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_STRIDE, &stride);
+			glGetVertexAttribPointerv(i, GL_VERTEX_ATTRIB_ARRAY_POINTER, &pointer);
+
+			OnBindBuffer(GL_ARRAY_BUFFER, buffer);
+			OnVertexAttrib(i, count, type, (unsigned char)normalized, stride, (GLuint)(uintptr_t)pointer);
+		}
+
+		GLint elementBuffer = 0;
+		glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &elementBuffer);
+		OnBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+	}
+	glBindVertexArray(vertexArray);
+
+	// uniform values live in the program too, we only read back the types our Shader can set
+	for (const auto& shader : m_Programs)
+	{
+		OnUseProgram(shader.first);
+
+		GLint uniformCount = 0;
+		glGetProgramiv(shader.first, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+		for (GLint i = 0; i < uniformCount; i++)
+		{
+			char name[256];
+			GLsizei length;
+			GLint size;
+			GLenum type;
+			glGetActiveUniform(shader.first, i, sizeof(name), &length, &size, &type, name);
+
+			GLint location = glGetUniformLocation(shader.first, name);
+			if (location == -1)
+				continue;
+
+			switch (type)
+			{
+				case GL_INT:
+				case GL_SAMPLER_2D:
+				{
+					GLint value;
+					glGetUniformiv(shader.first, location, &value);
+					OnUniform1i(shader.first, name, value);
+					break;
+				}
+				case GL_FLOAT_VEC4:
+				{
+					float value[4];
+					glGetUniformfv(shader.first, location, value);
+					OnUniform4f(shader.first, name, value[0], value[1], value[2], value[3]);
+					break;
+				}
+				case GL_FLOAT_MAT4:
+				{
+					float value[16];
+					glGetUniformfv(shader.first, location, value);
+					OnUniformMat4f(shader.first, name, value);
+					break;
+				}
+			}
+		}
+	}
+
+	// fixed function state set straight on GL rather than through a wrapper
+	GLint blendSrc, blendDst, viewport[4];
+	float clearColor[4];
+	glGetIntegerv(GL_BLEND_SRC_RGB, &blendSrc);
+	glGetIntegerv(GL_BLEND_DST_RGB, &blendDst);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+
+	WriteOp(GLTraceOp::STATE);
+	GLTraceWrite(m_Packet, (uint8_t)glIsEnabled(GL_BLEND));
+	GLTraceWrite(m_Packet, (uint32_t)blendSrc);
+	GLTraceWrite(m_Packet, (uint32_t)blendDst);
+	GLTraceWriteBytes(m_Packet, clearColor, sizeof(clearColor));
+	GLTraceWriteBytes(m_Packet, viewport, sizeof(viewport));
+
+	// and finally put the bindings back the way the frame will expect them
+	GLint textureUnits = 0;
+	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &textureUnits);
+
+	for (GLint i = 0; i < textureUnits; i++)
+	{
+		GLint texture = 0;
+		glActiveTexture(GL_TEXTURE0 + i);
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &texture);
+		if (texture == 0)
+			continue;
+
+		OnActiveTexture(i);
+		OnBindTexture(texture);
+	}
+	glActiveTexture(activeTexture);
+
+	OnActiveTexture(activeTexture - GL_TEXTURE0);
+	OnBindVertexArray(vertexArray);
+	OnBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+	OnUseProgram(program);
+
+	WriteOp(GLTraceOp::BEGIN_FRAMES);
+}
+
+void GLCapture::Flush()
+{
+	if (m_Packet.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_QueueMutex);
+		m_Queue.push_back(std::move(m_Packet));
+	}
+	m_QueueSignal.notify_one();
+
+	m_Packet = std::vector<unsigned char>();
+	m_Packet.reserve(64 * 1024);
+}
+
+void GLCapture::WriterLoop()
+{
+	std::unique_lock<std::mutex> lock(m_QueueMutex);
+
+	while (true)
+	{
+		m_QueueSignal.wait(lock, [this] { return m_StopWriter || !m_Queue.empty(); });
+
+		while (!m_Queue.empty())
+		{
+			std::vector<unsigned char> packet = std::move(m_Queue.front());
+			m_Queue.pop_front();
+
+			// don't hold the render thread up while we're on disk
+			lock.unlock();
+			m_File.write((const char*)packet.data(), packet.size());
+			if (!m_File)
+				m_WriteFailed = true;
+			lock.lock();
+		}
+
+		if (m_StopWriter)
+			return;
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "GL/glew.h"
+
+#include "GLTrace.h"
+
+// records what our wrappers send to GL into a trace that GLReplay can re-issue
+//
+// object creation is tracked all the time (just ids and sizes) so a capture can start
+// mid-run: Begin snapshots every live object and the bound state, then the calls follow
+// the render thread only packs bytes, a background thread does the file writes
+class GLCapture
+{
+private:
+	struct BufferInfo
+	{
+		GLenum Target;
+		GLuint Size;
+	};
+
+	struct TextureInfo
+	{
+		int Width, Height;
+	};
+
+	struct ProgramInfo
+	{
+		std::string VertexSource;
+		std::string FragmentSource;
+	};
+
+	std::unordered_map<GLuint, BufferInfo> m_Buffers;
+	std::unordered_map<GLuint, TextureInfo> m_Textures;
+	std::unordered_map<GLuint, ProgramInfo> m_Programs;
+	std::unordered_set<GLuint> m_VertexArrays;
+
+	bool m_Capturing;
+	GLuint m_FramesLeft;
+	GLuint m_FramesCaptured;
+
+	// content hashes already in the trace, so repeated uploads only cost 8 bytes
+	std::unordered_set<uint64_t> m_WrittenBlobs;
+
+	// what the render thread is filling right now
+	std::vector<unsigned char> m_Packet;
+
+	// handed off to the writer thread
+	std::thread m_Writer;
+	std::mutex m_QueueMutex;
+	std::condition_variable m_QueueSignal;
+	std::deque<std::vector<unsigned char>> m_Queue;
+	bool m_StopWriter;
+	std::ofstream m_File;
+	// set by the writer when the disk fails us, only read once it's joined
+	bool m_WriteFailed;
+
+public:
+	static GLCapture& Get();
+
+	~GLCapture();
+
+	// frames = 0 keeps going until End
+	bool Begin(const std::string& path, GLuint frames = 0);
+	void End();
+
+	inline bool IsCapturing() const { return m_Capturing; }
+
+	// object lifetime
+	void OnCreateBuffer(GLuint id, GLenum target, const void* data, GLuint size);
+	void OnDeleteBuffer(GLuint id);
+	void OnCreateTexture(GLuint id, int width, int height, const void* pixels);
+	void OnDeleteTexture(GLuint id);
+	void OnCreateProgram(GLuint id, const std::string& vertexSource, const std::string& fragmentSource);
+	void OnDeleteProgram(GLuint id);
+	void OnCreateVertexArray(GLuint id);
+	void OnDeleteVertexArray(GLuint id);
+
+	// calls, these do nothing unless we're capturing
+	void OnVertexAttrib(GLuint index, GLuint count, GLenum type, unsigned char normalized, GLuint stride, GLuint offset);
+	void OnBindBuffer(GLenum target, GLuint id);
+	void OnBindVertexArray(GLuint id);
+	void OnActiveTexture(GLuint slot);
+	void OnBindTexture(GLuint id);
+	void OnUseProgram(GLuint id);
+	void OnUniform1i(GLuint program, const std::string& name, int v0);
+	void OnUniform4f(GLuint program, const std::string& name, float v0, float v1, float v2, float v3);
+	void OnUniformMat4f(GLuint program, const std::string& name, const float* matrix);
+	void OnDrawElements(GLenum mode, GLuint count, GLenum type);
+	void OnClear(GLbitfield mask);
+	void OnEndFrame();
+
+private:
+	GLCapture();
+
+	inline void WriteOp(GLTraceOp op) { GLTraceWrite(m_Packet, (uint8_t)op); }
+	uint64_t WriteBlob(const void* data, size_t size);
+
+	void Snapshot();
+	void Flush();
+	void WriterLoop();
+};
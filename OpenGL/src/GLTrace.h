@@ -0,0 +1,144 @@
+#pragma once
+
+// the binary trace format shared by GLCapture (writes) and GLReplay (reads)
+//
+// a trace is a header followed by a stream of records, each one an op byte then its payload
+// everything is little endian, strings are a u16 length then the chars
+// big payloads (buffer data, pixels, shader source) go in BLOB records, written once
+// per unique content hash, and the calls that use them refer to the hash (0 means no data)
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const uint32_t GLTRACE_MAGIC = 0x54434C47; // "GLCT"
+static const uint32_t GLTRACE_VERSION = 1;
+
+enum class GLTraceOp : uint8_t
+{
+	BLOB = 0,               // u64 hash, u32 size, bytes
+	CREATE_BUFFER,          // u32 id, u32 target, u32 size, u64 blob
+	DELETE_BUFFER,          // u32 id
+	CREATE_TEXTURE,         // u32 id, i32 width, i32 height, u64 blob (RGBA8)
+	DELETE_TEXTURE,         // u32 id
+	CREATE_PROGRAM,         // u32 id, u64 vertex source blob, u64 fragment source blob
+	DELETE_PROGRAM,         // u32 id
+	CREATE_VERTEX_ARRAY,    // u32 id
+	DELETE_VERTEX_ARRAY,    // u32 id
+	VERTEX_ATTRIB,          // u32 index, u32 count, u32 type, u8 normalized, u32 stride, u32 offset
+	BIND_BUFFER,            // u32 target, u32 id
+	BIND_VERTEX_ARRAY,      // u32 id
+	ACTIVE_TEXTURE,         // u32 slot
+	BIND_TEXTURE,           // u32 id
+	USE_PROGRAM,            // u32 id
+	UNIFORM_1I,             // u32 program, string name, i32
+	UNIFORM_4F,             // u32 program, string name, 4 f32
+	UNIFORM_MAT4F,          // u32 program, string name, 16 f32
+	DRAW_ELEMENTS,          // u32 mode, u32 count, u32 type
+	CLEAR,                  // u32 mask
+	STATE,                  // u8 blend, u32 blend src, u32 blend dst, 4 f32 clear color, 4 i32 viewport
+	BEGIN_FRAMES,           // end of the snapshot, everything after is frames
+	END_FRAME,
+	COUNT
+};
+
+inline const char* GLTraceOpName(GLTraceOp op)
+{
+	static const char* names[] =
+	{
+		"Blob", "CreateBuffer", "DeleteBuffer", "CreateTexture", "DeleteTexture",
+		"CreateProgram", "DeleteProgram", "CreateVertexArray", "DeleteVertexArray",
+		"VertexAttrib", "BindBuffer", "BindVertexArray", "ActiveTexture", "BindTexture",
+		"UseProgram", "Uniform1i", "Uniform4f", "UniformMat4f", "DrawElements", "Clear",
+		"State", "BeginFrames", "EndFrame"
+	};
+	static_assert(sizeof(names) / sizeof(names[0]) == (size_t)GLTraceOp::COUNT, "every op needs a name");
+
+	return op < GLTraceOp::COUNT ? names[(size_t)op] : "Unknown";
+}
+
+// FNV-1a, plenty for telling uploads apart and fast enough to run on every one
+inline uint64_t GLTraceHash(const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t hash = 14695981039346656037ull;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+template<typename T>
+inline void GLTraceWrite(std::vector<unsigned char>& out, const T& value)
+{
+	const unsigned char* bytes = (const unsigned char*)&value;
+	out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+inline void GLTraceWriteBytes(std::vector<unsigned char>& out, const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+inline void GLTraceWriteString(std::vector<unsigned char>& out, const std::string& value)
+{
+	GLTraceWrite(out, (uint16_t)value.size());
+	GLTraceWriteBytes(out, value.data(), value.size());
+}
+
+// walks a trace in memory, once it runs off the end every read returns zeros and Failed() is true
+class GLTraceReader
+{
+private:
+	const unsigned char* m_Cursor;
+	const unsigned char* m_End;
+	bool m_Failed;
+
+public:
+	GLTraceReader(const unsigned char* data, size_t size)
+		: m_Cursor{ data }, m_End{ data + size }, m_Failed{ false } {}
+
+	template<typename T>
+	T Read()
+	{
+		T value{};
+		ReadBytes(&value, sizeof(T));
+		return value;
+	}
+
+	const unsigned char* Skip(size_t size)
+	{
+		if ((size_t)(m_End - m_Cursor) < size)
+		{
+			m_Failed = true;
+			m_Cursor = m_End;
+			return nullptr;
+		}
+
+		const unsigned char* start = m_Cursor;
+		m_Cursor += size;
+		return start;
+	}
+
+	void ReadBytes(void* out, size_t size)
+	{
+		const unsigned char* start = Skip(size);
+		if (start)
+			memcpy(out, start, size);
+	}
+
+	std::string ReadString()
+	{
+		uint16_t length = Read<uint16_t>();
+		const unsigned char* start = Skip(length);
+		return start ? std::string((const char*)start, length) : std::string();
+	}
+
+	inline bool AtEnd() const { return m_Cursor >= m_End; }
+	inline bool Failed() const { return m_Failed; }
+};
@@ -1,4 +1,5 @@
 #include "IndexBuffer.h"
+#include "GLCapture.h"
 
 IndexBuffer::IndexBuffer(const GLuint* data, GLuint count)
 {
@@ -6,21 +7,26 @@ IndexBuffer::IndexBuffer(const GLuint* data, GLuint count)
 	glGenBuffers(1, &m_RendererID);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_Count * sizeof(GLuint), data, GL_STATIC_DRAW);
+
+	// creating it binds it into whatever vertex array is bound, so the trace needs the bind too
+	GLCapture::Get().OnCreateBuffer(m_RendererID, GL_ELEMENT_ARRAY_BUFFER, data, m_Count * sizeof(GLuint));
+	GLCapture::Get().OnBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 IndexBuffer::~IndexBuffer()
 {
 	glDeleteBuffers(1, &m_RendererID);
+	GLCapture::Get().OnDeleteBuffer(m_RendererID);
 }
 
 void IndexBuffer::Bind() const
 {
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-
+	GLCapture::Get().OnBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::Unbind() const
 {
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
+	GLCapture::Get().OnBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
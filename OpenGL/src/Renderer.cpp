@@ -1,4 +1,5 @@
 #include "Renderer.h"
+#include "GLCapture.h"
 #include <iostream>
 
 void GLClearError()
@@ -23,11 +24,12 @@ void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib, const Shader&
 	ib.Bind();
 
 	glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr);
-
+	GLCapture::Get().OnDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT);
 }
 
 void Renderer::Clear() const
 {
 	glClear(GL_COLOR_BUFFER_BIT);
+	GLCapture::Get().OnClear(GL_COLOR_BUFFER_BIT);
 }
 
@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "GLCapture.h"
 
 
 Shader::Shader(const std::string& filepath)
@@ -9,37 +10,44 @@ Shader::Shader(const std::string& filepath)
 	GLuint shader = CreateShader(source.VertexSource, source.FragmentSource);
 
 	m_RendererID = shader;
+
+	GLCapture::Get().OnCreateProgram(m_RendererID, source.VertexSource, source.FragmentSource);
 }
 
 Shader::~Shader()
 {
 	glDeleteProgram(m_RendererID);
+	GLCapture::Get().OnDeleteProgram(m_RendererID);
 }
 
 void Shader::Bind() const
 {
 	glUseProgram(m_RendererID);
+	GLCapture::Get().OnUseProgram(m_RendererID);
 }
 
 void Shader::Unbind() const
 {
 	glUseProgram(0);
+	GLCapture::Get().OnUseProgram(0);
 }
 
 void Shader::SetUniform1i(const std::string& name, int v0)
 {
 	glUniform1i(GetUniformLocation(name), v0);
-
+	GLCapture::Get().OnUniform1i(m_RendererID, name, v0);
 }
 
 void Shader::SetUniform4f(const std::string& name, float v0, float v1, float v2, float v3)
 {
 	glUniform4f(GetUniformLocation(name), v0, v1, v2, v3);
+	GLCapture::Get().OnUniform4f(m_RendererID, name, v0, v1, v2, v3);
 }
 
 void Shader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
 {
 	glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &matrix[0][0]);
+	GLCapture::Get().OnUniformMat4f(m_RendererID, name, &matrix[0][0]);
 }
 
 int Shader::GetUniformLocation(const std::string& name)
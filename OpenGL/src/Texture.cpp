@@ -1,5 +1,6 @@
 #include "Texture.h"
 #include "stb/stb_image.h"
+#include "GLCapture.h"
 
 Texture::Texture(const std::string& path)
 	:m_Filepath{ path }, m_LocalBuffer{ nullptr }, m_Width{ 0 }, m_Height{ 0 }, m_BPP{ 0 }
@@ -25,6 +26,10 @@ Texture::Texture(const std::string& path)
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 
+	// has to happen before we free the local copy, the capture may need the pixels
+	GLCapture::Get().OnCreateTexture(m_RendererID, m_Width, m_Height, m_LocalBuffer);
+	GLCapture::Get().OnBindTexture(0);
+
 	if (m_LocalBuffer)
 	{
 		stbi_image_free(m_LocalBuffer);
@@ -35,16 +40,20 @@ Texture::Texture(const std::string& path)
 Texture::~Texture()
 {
 	glDeleteTextures(1, &m_RendererID);
+	GLCapture::Get().OnDeleteTexture(m_RendererID);
 }
 
 void Texture::Bind(GLuint slot/*=0*/) const
 {
 	glActiveTexture(GL_TEXTURE0 + slot);
 	glBindTexture(GL_TEXTURE_2D, m_RendererID);
+
+	GLCapture::Get().OnActiveTexture(slot);
+	GLCapture::Get().OnBindTexture(m_RendererID);
 }
 
 void Texture::Unbind() const
 {
 	glBindTexture(GL_TEXTURE_2D, 0);
-
+	GLCapture::Get().OnBindTexture(0);
 }
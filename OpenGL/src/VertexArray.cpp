@@ -1,15 +1,18 @@
 #include "VertexArray.h"
 #include "Renderer.h"
 #include "VertexBufferLayout.h"
+#include "GLCapture.h"
 
 VertexArray::VertexArray()
 {
 	glGenVertexArrays(1, &m_RendererID);
+	GLCapture::Get().OnCreateVertexArray(m_RendererID);
 }
 
 VertexArray::~VertexArray()
 {
 	glDeleteVertexArrays(1, &m_RendererID);
+	GLCapture::Get().OnDeleteVertexArray(m_RendererID);
 }
 
 void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout)
@@ -29,6 +32,7 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
 		// this binds the buffer with the vao
 		// the first 0 referrs to the 0 index of the vao
 		glVertexAttribPointer(i, element.count, element.type, element.normalized, layout.GetStride(), (const void*) offset);
+		GLCapture::Get().OnVertexAttrib(i, element.count, element.type, element.normalized, layout.GetStride(), offset);
 		offset += element.count * VertexBufferElement::GetSizeOfType(element.type);
 	}
 }
@@ -36,10 +40,12 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
 void VertexArray::Bind() const
 {
 	glBindVertexArray(m_RendererID);
+	GLCapture::Get().OnBindVertexArray(m_RendererID);
 }
 
 void VertexArray::Unbind() const
 {
 	glBindVertexArray(0);
+	GLCapture::Get().OnBindVertexArray(0);
 }
 
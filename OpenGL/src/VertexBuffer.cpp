@@ -1,25 +1,30 @@
 #include "VertexBuffer.h"
+#include "GLCapture.h"
 
 VertexBuffer::VertexBuffer(const void* data, unsigned int size)
 {
 	glGenBuffers(1, &m_RendererID);
 	glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 	glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+
+	GLCapture::Get().OnCreateBuffer(m_RendererID, GL_ARRAY_BUFFER, data, size);
+	GLCapture::Get().OnBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 }
 
 VertexBuffer::~VertexBuffer()
 {
 	glDeleteBuffers(1, &m_RendererID);
+	GLCapture::Get().OnDeleteBuffer(m_RendererID);
 }
 
 void VertexBuffer::Bind() const
 {
 	glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-
+	GLCapture::Get().OnBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 }
 
 void VertexBuffer::Unbind() const
 {
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
+	GLCapture::Get().OnBindBuffer(GL_ARRAY_BUFFER, 0);
 }
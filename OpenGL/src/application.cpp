@@ -10,6 +10,8 @@
 
 #include "Shader.h"
 #include "Texture.h"
+#include "FramePacer.h"
+#include "GLCapture.h"
 
 #include "glm\glm.hpp"
 #include "glm\gtc\matrix_transform.hpp"
@@ -37,14 +39,6 @@ int main(void)
 	/* Make the window's context current */
 	glfwMakeContextCurrent(window);
 
-	// we need a current context to call this, and we do have one. It's window
-	// this sets vsync = number of frame updates to wait before buffers are swapped
-	// less than zero immediately swaps, ready or not
-	// 0 is fast
-	// 1 stops tearing
-	// we almost always want this to be 1
-	glfwSwapInterval(1);
-
 	if (glewInit() != GLEW_OK)
 	{
 		std::cout << "Error!" << std::endl;
@@ -136,38 +130,83 @@ int main(void)
 
 	Renderer renderer;
 
-	// these will allow us to change the uniform color in flight
-	float red = 0.0f;
-	float increment = 0.05f;
-
-	/* Loop until the user closes the window */
-	while (!glfwWindowShouldClose(window))
+	// the pacer holds fences and queries, so it has to go before the context does
 	{
-		/* Render here */
-		renderer.Clear();
-
-		//shader.Bind();
-		shader.SetUniform4f("u_Color", red, 0.3f, 0.8f, 1.0f);
-
-		// the big daddy of drawing!!!!
-		GLClearError();
-		renderer.Draw(va, ib, shader);
-		GLCheckError();
-
-		// now that it's drawn, we can change the color
-		if (red > 1.0f)
-			increment = -0.05f;
-		else if (red < 0.0f)
-			increment = 0.05f;
-
-		red += increment;
-
-		/* Swap front and back buffers */
-		// here our color was changed and sitting in the back buffer
-		glfwSwapBuffers(window);
-
-		/* Poll for and process events */
-		glfwPollEvents();
+		// the swap interval used to be hard coded to 1 here, now the pacer owns it
+		// it also caps how many frames the gpu can fall behind us, and runs the
+		// simulation on a fixed step no matter how fast we render
+		// press 1-4 to switch between vsync, adaptive vsync, uncapped and a 120fps limiter
+		// F12 captures the next 120 frames for GLReplay
+		FramePacer pacer(FramePacer::Mode::VSYNC, 120.0);
+		glfwSetWindowUserPointer(window, &pacer);
+		glfwSetKeyCallback(window, [](GLFWwindow* window, int key, int scancode, int action, int mods)
+		{
+			if (action != GLFW_PRESS)
+				return;
+
+			if (key == GLFW_KEY_F12)
+			{
+				GLCapture::Get().Begin("capture.gltrace", 120);
+				return;
+			}
+
+			if (key < GLFW_KEY_1 || key > GLFW_KEY_4)
+				return;
+
+			FramePacer* pacer = (FramePacer*)glfwGetWindowUserPointer(window);
+			pacer->SetMode((FramePacer::Mode)(key - GLFW_KEY_1));
+		});
+
+		// these will allow us to change the uniform color in flight
+		// we keep the last two simulated values so rendering can blend between them
+		float red = 0.0f;
+		float previousRed = red;
+		float increment = 0.05f;
+
+		/* Loop until the user closes the window */
+		while (!glfwWindowShouldClose(window))
+		{
+			pacer.BeginFrame();
+
+			/* Poll for and process events */
+			// as late as we can, so the frame we draw is built from the freshest input
+			glfwPollEvents();
+			pacer.MarkInputSampled();
+
+			// step the color at a fixed rate, however many times we owe this frame
+			while (pacer.StepSimulation())
+			{
+				previousRed = red;
+
+				if (red > 1.0f)
+					increment = -0.05f;
+				else if (red < 0.0f)
+					increment = 0.05f;
+
+				red += increment;
+			}
+
+			float alpha = pacer.GetInterpolationAlpha();
+			float renderRed = previousRed + (red - previousRed) * alpha;
+
+			/* Render here */
+			renderer.Clear();
+
+			//shader.Bind();
+			shader.SetUniform4f("u_Color", renderRed, 0.3f, 0.8f, 1.0f);
+
+			// the big daddy of drawing!!!!
+			GLClearError();
+			renderer.Draw(va, ib, shader);
+			GLCheckError();
+
+			/* Swap front and back buffers */
+			// here our color was changed and sitting in the back buffer
+			pacer.Present(window);
+			GLCapture::Get().OnEndFrame();
+		}
+
+		GLCapture::Get().End();
 	}
 
 	glfwTerminate();